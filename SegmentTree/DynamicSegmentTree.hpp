@@ -1,3 +1,4 @@
+#pragma once
 #include <vector>
 #include <cstddef>
 
@@ -25,17 +26,17 @@ public:
 
 	Node<T>& operator=(const Node<T>& node);
 
-	void clear();
+	size_t clear();
 	~Node<T>() {}
 
-	template <class T>
+	template <class U, class S>
 	friend class DynamicSegmentTree;
 
-	template <class T>
+	template <class U, class S>
 	friend class PersistentSegmentTree;
 
-	template <class T>
-	friend void FillRecursively(std::vector<std::pair<size_t, T>>& vect, Node<T>* current);
+	template <class U>
+	friend void FillRecursively(std::vector<std::pair<size_t, U>>& vect, Node<U>* current);
 };
 
 template <class T>
@@ -46,7 +47,7 @@ Node<T>& Node<T>::operator=(const Node<T>& node) {
 		throw 'e';
 	this->clear();
 	delete this;
-	FillChildsRecursive(Node<T>&node);
+	FillChildsRecursive(node);
 	return *this;
 }
 
@@ -62,16 +63,21 @@ void Node<T>::FillChildsRecursive(const Node<T>& node) {
 		node->right->FillChildsRecursive(this->right);
 	}
 }
+/*
+deletes every node under this one, returns how many were deleted
+*/
 template <class T>
-void Node<T>::clear() {
+size_t Node<T>::clear() {
+	size_t count = 0;
 	if (left) {
-		left->clear();
+		count += left->clear() + 1;
 		delete left;
 	}
 	if (right) {
-		right->clear();
+		count += right->clear() + 1;
 		delete right;
 	}
+	return count;
 }
 
 /*
@@ -96,6 +102,8 @@ private:
 public:
 
 	explicit CompressedTree<T>(std::vector<std::pair<size_t, T>> vect);
+	template <class Iterator>
+	CompressedTree(Iterator begin, Iterator end);
 
 	void UpdateElement(size_t position, T value);
 
@@ -112,8 +120,8 @@ public:
 
 size -   ,     SegmentTree         
   2^k, actual_size        . */
-template <class T>
-class DynamicSegmentTree {
+template <class T, class StatsPolicy = DefaultStats>
+class DynamicSegmentTree : private StatsPolicy {
 private:
 	size_t size;
 	Node<T>* head;
@@ -122,10 +130,15 @@ private:
 
 	T GetSum(size_t left, size_t right, Node<T>* cur_pos);
 
+	Node<T>* Merge(Node<T>* cur_pos, Node<T>* other_pos);
+	Node<T>* Split(Node<T>* cur_pos, size_t position, DynamicSegmentTree<T, StatsPolicy>& other);
+
+	static size_t CountNodes(Node<T>* cur_pos);
+
 public:
 
-	explicit DynamicSegmentTree<T>(Node<T>* head, size_t size) : head(head), size(size) {}
-	explicit DynamicSegmentTree<T>(size_t size) : head(nullptr), size(size) {}
+	explicit DynamicSegmentTree(Node<T>* head, size_t size) : head(head), size(size) {}
+	explicit DynamicSegmentTree(size_t size) : head(nullptr), size(size) {}
 
 	void UpdateElement(size_t position, T value);
 	void SetElement(size_t position, T value);
@@ -137,7 +150,15 @@ public:
 
 	CompressedTree<T> Compress();
 
-	~DynamicSegmentTree<T>();
+	void Merge(DynamicSegmentTree<T, StatsPolicy>& other);
+	DynamicSegmentTree<T, StatsPolicy>* Split(size_t position);
+
+	template <class Iterator>
+	static DynamicSegmentTree<T, StatsPolicy>* FromSorted(Iterator begin, Iterator end, size_t size);
+
+	using StatsPolicy::Stats;
+
+	~DynamicSegmentTree();
 };
 
 
@@ -146,17 +167,21 @@ public:
 /*
 update a[i] by value, which means a[i]+=value
 */
-template <class T>
-void DynamicSegmentTree<T>::UpdateElement(size_t position, T value) {
-	if (!head)
+template <class T, class StatsPolicy>
+void DynamicSegmentTree<T, StatsPolicy>::UpdateElement(size_t position, T value) {
+	typename StatsPolicy::Scope scope(*this, true);
+	if (!head) {
 		head = new Node<T>(0, size - 1, value);
+		this->Allocate();
+	}
 	else
 		head->sum += value;
 	UpdateElement(position, value, 0, size - 1, head);
 }
 
-template <class T>
-void DynamicSegmentTree<T>::SetElement(size_t position, T value) {
+template <class T, class StatsPolicy>
+void DynamicSegmentTree<T, StatsPolicy>::SetElement(size_t position, T value) {
+	typename StatsPolicy::Scope scope(*this, true);
 	if (IsExist(position)) {
 		T new_value = value - GetValue(position);
 		UpdateElement(position, new_value);
@@ -171,12 +196,14 @@ void DynamicSegmentTree<T>::SetElement(size_t position, T value) {
 	*/
 }
 
-template <class T>
-bool DynamicSegmentTree<T>::IsExist(size_t position) {
+template <class T, class StatsPolicy>
+bool DynamicSegmentTree<T, StatsPolicy>::IsExist(size_t position) {
+	typename StatsPolicy::Scope scope(*this, false);
 	if (!head) return false;
 	Node<T>* current = head;
 	size_t mid;
 	while (current) {
+		this->Visit();
 		if (current->tl == current->tr)
 			return true;
 		mid = (current->tl + current->tr) / 2 + 1;
@@ -190,11 +217,13 @@ bool DynamicSegmentTree<T>::IsExist(size_t position) {
 	return false;
 }
 
-template <class T>
-T DynamicSegmentTree<T>::GetValue(size_t position) {
+template <class T, class StatsPolicy>
+T DynamicSegmentTree<T, StatsPolicy>::GetValue(size_t position) {
+	typename StatsPolicy::Scope scope(*this, false);
 	Node<T>* current = head;
 	size_t mid;
 	while (current) {
+		this->Visit();
 		if (current->tl == current->tr)
 			return current->sum;
 		mid = (current->tl + current->tr) / 2 + 1;
@@ -207,14 +236,16 @@ T DynamicSegmentTree<T>::GetValue(size_t position) {
 	}
 }
 
-template <class T>
-T DynamicSegmentTree<T>::GetSum(size_t left, size_t right) {
+template <class T, class StatsPolicy>
+T DynamicSegmentTree<T, StatsPolicy>::GetSum(size_t left, size_t right) {
+	typename StatsPolicy::Scope scope(*this, false);
 	if (!head) return 0;
 	return GetSum(left, right, head);
 }
 
-template <class T>
-void DynamicSegmentTree<T>::UpdateElement(size_t position, T value, size_t tl, size_t tr, Node<T>* cur_pos) {
+template <class T, class StatsPolicy>
+void DynamicSegmentTree<T, StatsPolicy>::UpdateElement(size_t position, T value, size_t tl, size_t tr, Node<T>* cur_pos) {
+	this->Visit();
 	if (tl == tr) {
 		return;
 	}
@@ -222,6 +253,7 @@ void DynamicSegmentTree<T>::UpdateElement(size_t position, T value, size_t tl, s
 	if (position < mid) {
 		if (!cur_pos->left) {
 			cur_pos->left = new Node<T>(tl, mid - 1, value);
+			this->Allocate();
 		}
 		else {
 			cur_pos->left->sum += value;
@@ -231,6 +263,7 @@ void DynamicSegmentTree<T>::UpdateElement(size_t position, T value, size_t tl, s
 	else {
 		if (!cur_pos->right) {
 			cur_pos->right = new Node<T>(mid, tr, value);
+			this->Allocate();
 		}
 		else {
 			cur_pos->right->sum += value;
@@ -240,8 +273,9 @@ void DynamicSegmentTree<T>::UpdateElement(size_t position, T value, size_t tl, s
 
 }
 
-template <class T>
-T DynamicSegmentTree<T>::GetSum(size_t left, size_t right, Node<T>* cur_pos) {
+template <class T, class StatsPolicy>
+T DynamicSegmentTree<T, StatsPolicy>::GetSum(size_t left, size_t right, Node<T>* cur_pos) {
+	this->Visit();
 	if (cur_pos->tl == cur_pos->tr)
 		return cur_pos->sum;
 
@@ -257,7 +291,184 @@ T DynamicSegmentTree<T>::GetSum(size_t left, size_t right, Node<T>* cur_pos) {
 	return sum;
 }
 
+/*
+a[i] += other.a[i] for every i, nodes of other are moved into this tree and other becomes empty.
+Only nodes that exist in both trees are visited, the rest is relinked as whole subtrees.
+*/
+template <class T, class StatsPolicy>
+void DynamicSegmentTree<T, StatsPolicy>::Merge(DynamicSegmentTree<T, StatsPolicy>& other) {
+	if (size != other.size)
+		throw 'e';
+	if (this == &other)
+		return;
+	typename StatsPolicy::Scope scope(*this, true);
+	other.Transfer(*this, other.Stats().live_nodes);
+	head = Merge(head, other.head);
+	other.head = nullptr;
+}
+
+template <class T, class StatsPolicy>
+Node<T>* DynamicSegmentTree<T, StatsPolicy>::Merge(Node<T>* cur_pos, Node<T>* other_pos) {
+	if (!cur_pos) return other_pos;
+	if (!other_pos) return cur_pos;
+	this->Visit();
+
+	cur_pos->sum += other_pos->sum;
+	cur_pos->left = Merge(cur_pos->left, other_pos->left);
+	cur_pos->right = Merge(cur_pos->right, other_pos->right);
+	delete other_pos;
+	this->Release();
+	return cur_pos;
+}
 
+/*
+cuts the tree by position: this tree keeps [0, position), the returned one gets [position, size).
+Only the path to position is walked, everything right of it is relinked, so it is O(log size).
+The returned tree is allocated with new, like the trees in the tests.
+With a node counting stats policy the relinked subtrees are counted to move them to the stats of the
+returned tree, so then Split is O(moved nodes).
+*/
+template <class T, class StatsPolicy>
+DynamicSegmentTree<T, StatsPolicy>* DynamicSegmentTree<T, StatsPolicy>::Split(size_t position) {
+	typename StatsPolicy::Scope scope(*this, true);
+	DynamicSegmentTree<T, StatsPolicy>* other = new DynamicSegmentTree<T, StatsPolicy>(size);
+	if (position == 0) {
+		this->Transfer(*other, this->Stats().live_nodes);
+		other->head = head;
+		head = nullptr;
+	}
+	else if (head && position < size) {
+		other->head = Split(head, position, *other);
+		if (!head->left && !head->right) {
+			delete head;
+			this->Release();
+			head = nullptr;
+		}
+	}
+	return other;
+}
+
+/*
+cur_pos->tl < position <= cur_pos->tr. Returns the node of other over the same segment (or nullptr
+if nothing is moved), children of cur_pos that become empty are deleted.
+*/
+template <class T, class StatsPolicy>
+Node<T>* DynamicSegmentTree<T, StatsPolicy>::Split(Node<T>* cur_pos, size_t position, DynamicSegmentTree<T, StatsPolicy>& other) {
+	this->Visit();
+	size_t mid = (cur_pos->tl + cur_pos->tr) / 2 + 1;
+	Node<T>* left = nullptr;
+	Node<T>* right = nullptr;
+
+	if (position <= mid) {
+		right = cur_pos->right;
+		cur_pos->right = nullptr;
+		if (StatsPolicy::CountsNodes && right)
+			this->Transfer(other, CountNodes(right));
+		if (position < mid && cur_pos->left) {
+			left = Split(cur_pos->left, position, other);
+			if (!cur_pos->left->left && !cur_pos->left->right) {
+				delete cur_pos->left;
+				this->Release();
+				cur_pos->left = nullptr;
+			}
+		}
+	}
+	else if (cur_pos->right) {
+		right = Split(cur_pos->right, position, other);
+		if (!cur_pos->right->left && !cur_pos->right->right) {
+			delete cur_pos->right;
+			this->Release();
+			cur_pos->right = nullptr;
+		}
+	}
+
+	if (!left && !right)
+		return nullptr;
+	Node<T>* other_pos = new Node<T>(cur_pos->tl, cur_pos->tr, T(0));
+	other.Allocate();
+	other_pos->left = left;
+	other_pos->right = right;
+	if (left) other_pos->sum += left->sum;
+	if (right) other_pos->sum += right->sum;
+	cur_pos->sum -= other_pos->sum;
+	return other_pos;
+}
+
+template <class T, class StatsPolicy>
+size_t DynamicSegmentTree<T, StatsPolicy>::CountNodes(Node<T>* cur_pos) {
+	if (!cur_pos) return 0;
+	return 1 + CountNodes(cur_pos->left) + CountNodes(cur_pos->right);
+}
+
+/*
+Builds the tree from (position, value) pairs sorted by position, equal positions are added up.
+The nodes of the previous position stay on a stack: for the next position the stack is popped up to
+the first node that covers it and only the missing part of the path is created. A node gets its sum
+when it is popped, so every node is created and finished once: O(k + number of nodes), no descents
+from the root and no lookups of existing nodes.
+
+The nodes are still allocated one by one with new, like in UpdateElement, so the load does not get
+sequential writes: the tree frees, merges and splits nodes one at a time and cannot own a block.
+The whole load is counted as one update.
+*/
+template <class T, class StatsPolicy>
+template <class Iterator>
+DynamicSegmentTree<T, StatsPolicy>* DynamicSegmentTree<T, StatsPolicy>::FromSorted(Iterator begin, Iterator end, size_t size) {
+	DynamicSegmentTree<T, StatsPolicy>* tree = new DynamicSegmentTree<T, StatsPolicy>(size);
+	std::vector<Node<T>*> path;
+	bool first = true;
+	bool sorted = true;
+	size_t previous = 0;
+	{
+		typename StatsPolicy::Scope scope(*tree, true);
+
+		for (; begin != end; ++begin) {
+			size_t position = (*begin).first;
+			if (position >= size || (!first && position < previous)) {
+				sorted = false;
+				break;
+			}
+			first = false;
+			previous = position;
+
+			while (!path.empty() && (position < path.back()->tl || position > path.back()->tr)) {
+				Node<T>* finished = path.back();
+				path.pop_back();
+				path.back()->sum += finished->sum;
+			}//the root covers every position, so it is never popped here
+
+			if (path.empty()) {
+				tree->head = new Node<T>(0, size - 1, T(0));
+				tree->Allocate();
+				path.push_back(tree->head);
+			}
+			Node<T>* current = path.back();
+			while (current->tl != current->tr) {
+				size_t mid = (current->tl + current->tr) / 2 + 1;
+				Node<T>*& child = position < mid ? current->left : current->right;
+				if (!child) {
+					child = position < mid ? new Node<T>(current->tl, mid - 1, T(0)) : new Node<T>(mid, current->tr, T(0));
+					tree->Allocate();
+				}
+				current = child;
+				path.push_back(current);
+			}
+			current->sum += (*begin).second;
+		}
+
+		while (path.size() > 1) {
+			Node<T>* finished = path.back();
+			path.pop_back();
+			path.back()->sum += finished->sum;
+		}
+	}//the scope has to end before tree is deleted
+
+	if (!sorted) {
+		delete tree;
+		throw 'e';
+	}
+	return tree;
+}
 
 template <class T>
 void FillRecursively(std::vector<std::pair<size_t, T>>& vect, Node<T>* current) {
@@ -275,8 +486,8 @@ void FillRecursively(std::vector<std::pair<size_t, T>>& vect, Node<T>* current)
 	}
 }
 
-template <class T>
-CompressedTree<T> DynamicSegmentTree<T>::Compress() {
+template <class T, class StatsPolicy>
+CompressedTree<T> DynamicSegmentTree<T, StatsPolicy>::Compress() {
 	std::vector<std::pair<size_t, T>> vect;
 	FillRecursively(vect, head);
 	return CompressedTree<T>(vect);
@@ -302,6 +513,39 @@ CompressedTree<T>::CompressedTree(std::vector<std::pair<size_t, T>> vect) {
 	}
 }
 
+/*
+Builds the tree straight from (position, value) pairs sorted by position, without a DynamicSegmentTree.
+Equal positions are added up. The leaves are written in one pass to the front of the array, then moved
+as one block to their place after the padding is known, and the upper levels are summed as usual.
+*/
+template <class T>
+template <class Iterator>
+CompressedTree<T>::CompressedTree(Iterator begin, Iterator end) {
+	for (; begin != end; ++begin) {
+		size_t position = (*begin).first;
+		if (!array.empty() && position < array.back().first)
+			throw 'e';
+		if (!array.empty() && position == array.back().first)
+			array.back().second += (*begin).second;
+		else
+			array.push_back(std::pair<size_t, T>(position, (*begin).second));
+	}
+	actual_size = array.size();
+
+	size_t size_ = 1;
+	while (size_ < actual_size)
+		size_ <<= 1;
+	this->size = 2 * size_ - 1;
+	this->array.resize(this->size, std::pair<size_t, T>(0, T(0)));
+
+	std::move_backward(array.begin(), array.begin() + actual_size, array.begin() + (size_ - 1 + actual_size));
+	std::fill(array.begin(), array.begin() + std::min(size_ - 1, actual_size), std::pair<size_t, T>(0, T(0)));
+
+	for (int i = size_ - 2; i >= 0; --i) {
+		this->array[i].second = this->array[2 * i + 1].second + this->array[2 * i + 2].second;
+	}
+}
+
 /*
   position   position     ,
      ,     
@@ -412,9 +656,10 @@ T CompressedTree<T>::GetSum(size_t position, size_t tl, size_t tr, size_t l, siz
 	return ans;
 }
 
-template <class T>
-DynamicSegmentTree<T>::~DynamicSegmentTree() {
-	head->clear();
-	if (head)
+template <class T, class StatsPolicy>
+DynamicSegmentTree<T, StatsPolicy>::~DynamicSegmentTree() {
+	if (head) {
+		this->Release(head->clear() + 1);
 		delete head;
+	}
 }
\ No newline at end of file
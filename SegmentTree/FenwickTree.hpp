@@ -0,0 +1,195 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+/*
+Fenwick (binary indexed) tree for the sum-only case of SegmentTree: point set, range sum and GetMin.
+It keeps exactly n values instead of the 2 * 2^k - 1 of SegmentTree and every operation is one loop
+over the bits of the index instead of a recursive descent.
+
+Internally indices are 1-based: bits[i - 1] holds the sum of a(i - lowbit(i), i].
+*/
+template <class T>
+class FenwickTree {
+private:
+	size_t size;
+	std::vector<T> bits;
+
+	void Add(size_t position, T value);
+	T GetPrefix(size_t count);
+public:
+	explicit FenwickTree<T>(std::vector<T> vect);
+
+	void UpdateElement(size_t position, T value);
+	void SetElement(size_t position, T value);
+
+	T GetSum(size_t left, size_t right);
+	size_t GetMin(size_t left, T sum);
+
+	size_t Count() { return size; }
+
+	~FenwickTree<T>() {}
+};
+
+template <class T>
+FenwickTree<T>::FenwickTree(std::vector<T> vect) : size(vect.size()), bits(vect) {
+	for (size_t i = 1; i <= size; ++i) {
+		size_t parent = i + (i & (~i + 1));
+		if (parent <= size)
+			bits[parent - 1] += bits[i - 1];
+	}//O(n): every node pushes its sum to the next node covering it
+}
+
+template <class T>
+void FenwickTree<T>::Add(size_t position, T value) {
+	for (size_t i = position + 1; i <= size; i += i & (~i + 1)) {
+		bits[i - 1] += value;
+	}
+}
+
+/*
+sum of the first count elements
+*/
+template <class T>
+T FenwickTree<T>::GetPrefix(size_t count) {
+	T sum = T(0);
+	for (size_t i = count; i; i -= i & (~i + 1)) {
+		sum += bits[i - 1];
+	}
+	return sum;
+}
+
+/*
+update a[i] by value, which means a[i]+=value
+*/
+template <class T>
+void FenwickTree<T>::UpdateElement(size_t position, T value) {
+	if (position >= size)
+		throw 'e';
+	Add(position, value);
+}
+
+template <class T>
+void FenwickTree<T>::SetElement(size_t position, T value) {
+	if (position >= size)
+		throw 'e';
+	Add(position, value - GetSum(position, position));
+}
+
+template <class T>
+T FenwickTree<T>::GetSum(size_t left, size_t right) {
+	if (right >= size || right < left)
+		throw 'e';
+	return GetPrefix(right + 1) - GetPrefix(left);
+}
+
+/*
+returns minimum index k such that a[left] + a[left+1] + ... + a[k] >= sum, or Count() if there is none.
+Elements have to be non-negative, then the prefix sums are sorted and the search is one descent
+over the powers of two.
+*/
+template <class T>
+size_t FenwickTree<T>::GetMin(size_t left, T sum) {
+	T target = sum + GetPrefix(left);
+	size_t step = 1;
+	while (step * 2 <= size)
+		step *= 2;
+
+	size_t position = 0;
+	T cur_sum = T(0);
+	for (; step; step /= 2) {
+		if (position + step <= size && cur_sum + bits[position + step - 1] < target) {
+			position += step;
+			cur_sum += bits[position - 1];
+		}
+	}
+	return position < left ? left : position;
+}
+
+
+/*
+Fenwick tree with range update and range sum. It keeps two FenwickTree over the difference array d:
+add holds d[i] and correction holds d[i] * i, then the prefix sum of the first n elements is
+n * sum(add) - sum(correction). Memory is 2n values, which is still less than SegmentTree.
+*/
+template <class T>
+class RangeFenwickTree {
+private:
+	size_t size;
+	FenwickTree<T> add;
+	FenwickTree<T> correction;
+
+	static std::vector<T> Differences(const std::vector<T>& vect);
+	static std::vector<T> Corrections(const std::vector<T>& vect);
+	T GetPrefix(size_t count);
+public:
+	explicit RangeFenwickTree<T>(std::vector<T> vect);
+
+	void UpdateRange(size_t left, size_t right, T value);
+
+	T GetSum(size_t left, size_t right);
+
+	size_t Count() { return size; }
+
+	~RangeFenwickTree<T>() {}
+};
+
+template <class T>
+RangeFenwickTree<T>::RangeFenwickTree(std::vector<T> vect)
+	: size(vect.size()), add(Differences(vect)), correction(Corrections(vect)) {}
+
+/*
+d[i] = a[i] - a[i - 1]
+*/
+template <class T>
+std::vector<T> RangeFenwickTree<T>::Differences(const std::vector<T>& vect) {
+	std::vector<T> differences(vect.size());
+	for (size_t i = 0; i < vect.size(); ++i) {
+		differences[i] = i ? vect[i] - vect[i - 1] : vect[i];
+	}
+	return differences;
+}
+
+/*
+d[i] * i
+*/
+template <class T>
+std::vector<T> RangeFenwickTree<T>::Corrections(const std::vector<T>& vect) {
+	std::vector<T> corrections = Differences(vect);
+	for (size_t i = 0; i < vect.size(); ++i) {
+		corrections[i] *= T(i);
+	}
+	return corrections;
+}
+
+/*
+sum of the first count elements
+*/
+template <class T>
+T RangeFenwickTree<T>::GetPrefix(size_t count) {
+	if (!count)
+		return T(0);
+	return add.GetSum(0, count - 1) * T(count) - correction.GetSum(0, count - 1);
+}
+
+/*
+a[i] += value for every i in [left, right]
+*/
+template <class T>
+void RangeFenwickTree<T>::UpdateRange(size_t left, size_t right, T value) {
+	if (right >= size || right < left)
+		throw 'e';
+	add.UpdateElement(left, value);
+	correction.UpdateElement(left, value * T(left));
+	if (right + 1 < size) {
+		add.UpdateElement(right + 1, T(0) - value);
+		correction.UpdateElement(right + 1, T(0) - value * T(right + 1));
+	}
+}
+
+template <class T>
+T RangeFenwickTree<T>::GetSum(size_t left, size_t right) {
+	if (right >= size || right < left)
+		throw 'e';
+	return GetPrefix(right + 1) - GetPrefix(left);
+}
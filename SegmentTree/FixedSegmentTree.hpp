@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+/*
+smallest power of two that is >= len, the integer counterpart of std::pow(2, findk(len))
+*/
+constexpr size_t FixedCapacity(size_t len) {
+	size_t capacity = 1;
+	while (capacity < len)
+		capacity <<= 1;
+	return capacity;
+}
+
+constexpr size_t FixedLevels(size_t capacity) {
+	size_t levels = 1;
+	while (capacity >>= 1)
+		++levels;
+	return levels;
+}
+
+/*
+SegmentTree with a capacity fixed at compile time. The nodes are an std::array in the same layout as
+SegmentTree (root at 0, children of i at 2i+1 and 2i+2, leaves from Capacity - 1), so there is no heap
+allocation, the tree is trivially copyable and many of them can be kept in one contiguous array.
+
+The number of levels is a compile time constant, so the loops below have constant bounds and are
+unrolled by the compiler. Everything is constexpr, a tree can be built and queried at compile time.
+*/
+template <class T, size_t N>
+class FixedSegmentTree {
+public:
+	static constexpr size_t Capacity = FixedCapacity(N);
+	static constexpr size_t Levels = FixedLevels(Capacity);
+private:
+	std::array<T, 2 * Capacity - 1> array;
+
+	constexpr void Build();
+public:
+	constexpr FixedSegmentTree() : array() {}
+	constexpr explicit FixedSegmentTree(const std::array<T, N>& vect);
+
+	constexpr void SetElement(size_t position, T value);
+
+	constexpr T GetSum(size_t left, size_t right) const;
+	constexpr size_t GetMin(size_t left, T sum) const;
+};
+
+template <class T, size_t N>
+constexpr FixedSegmentTree<T, N>::FixedSegmentTree(const std::array<T, N>& vect) : array() {
+	for (size_t i = 0; i < N; ++i) {
+		array[Capacity - 1 + i] = vect[i];
+	}//the last row of a tree = vect
+	Build();
+}
+
+template <class T, size_t N>
+constexpr void FixedSegmentTree<T, N>::Build() {
+	for (size_t i = Capacity - 1; i-- > 0;) {
+		array[i] = array[2 * i + 1] + array[2 * i + 2];
+	}
+}
+
+/*
+the path from a leaf to the root always has Levels - 1 steps
+*/
+template <class T, size_t N>
+constexpr void FixedSegmentTree<T, N>::SetElement(size_t position, T value) {
+	if (position >= N)
+		throw 'e';
+	size_t i = Capacity - 1 + position;
+	array[i] = value;
+	for (size_t level = 1; level < Levels; ++level) {
+		i = (i - 1) / 2;
+		array[i] = array[2 * i + 1] + array[2 * i + 2];
+	}
+}
+
+/*
+bottom-up: both borders go up one level per step, adding the nodes that stick out of the range
+*/
+template <class T, size_t N>
+constexpr T FixedSegmentTree<T, N>::GetSum(size_t left, size_t right) const {
+	if (right >= N || right < left)
+		throw 'e';
+	T ans = T(0);
+	size_t l = Capacity - 1 + left;
+	size_t r = Capacity - 1 + right;
+	for (size_t level = 0; level < Levels && l <= r; ++level) {
+		if (l % 2 == 0) ans += array[l++];//l is a right child
+		if (r % 2 == 1) ans += array[r--];//r is a left child
+		if (l > r) break;
+		l = (l - 1) / 2;
+		r = (r - 1) / 2;
+	}
+	return ans;
+}
+
+/*
+returns minimum index k such that a[left] + a[left+1] + ... + a[k] >= sum, or N if there is none.
+Elements have to be non-negative: the search is one descent from the root.
+*/
+template <class T, size_t N>
+constexpr size_t FixedSegmentTree<T, N>::GetMin(size_t left, T sum) const {
+	if (left >= N)
+		throw 'e';
+	T target = sum + (left ? GetSum(0, left - 1) : T(0));
+	if (array[0] < target)
+		return N;
+	size_t i = 0;
+	for (size_t level = 1; level < Levels; ++level) {
+		if (array[2 * i + 1] < target) {
+			target -= array[2 * i + 1];
+			i = 2 * i + 2;
+		}
+		else {
+			i = 2 * i + 1;
+		}
+	}
+	size_t k = i - (Capacity - 1);
+	return k < left ? left : k;
+}
@@ -1,3 +1,4 @@
+#pragma once
 #include <vector>
 #include <cstddef>
 
@@ -24,8 +25,8 @@
       ,  ).
 
 */
-template <class T>
-class PersistentSegmentTree {
+template <class T, class StatsPolicy = DefaultStats>
+class PersistentSegmentTree : private StatsPolicy {
 private:
 	size_t size;
 	Node<T>* head;
@@ -39,22 +40,23 @@ private:
 
 
 public:
-	explicit PersistentSegmentTree<T>(std::vector<T> vect);
+	explicit PersistentSegmentTree(std::vector<T> vect);
 
 	void UpdateElement(size_t position, T value);
 
 	T GetSum(size_t left, size_t right, size_t version);
 
+	using StatsPolicy::Stats;
 
-	~PersistentSegmentTree<T>();
+	~PersistentSegmentTree();
 };
 
 
 /*
       ,     .
 */
-template <class T>
-void PersistentSegmentTree<T>::MakeNodes(Node<T>* cur_pos, std::vector<T>& vect) {
+template <class T, class StatsPolicy>
+void PersistentSegmentTree<T, StatsPolicy>::MakeNodes(Node<T>* cur_pos, std::vector<T>& vect) {
 	if (cur_pos->tl == cur_pos->tr) {
 		cur_pos->sum += vect[cur_pos->tl];
 		return;
@@ -65,11 +67,13 @@ void PersistentSegmentTree<T>::MakeNodes(Node<T>* cur_pos, std::vector<T>& vect)
 	MakeNodes(cur_pos->left, vect);
 	cur_pos->right = new Node<T>(mid, cur_pos->tr, 0);
 	MakeNodes(cur_pos->right, vect);
+	this->Allocate();
+	this->Allocate();
 	cur_pos->sum += cur_pos->left->sum + cur_pos->right->sum;
 }
 
-template <class T>
-PersistentSegmentTree<T>::PersistentSegmentTree<T>(std::vector<T> vect) {
+template <class T, class StatsPolicy>
+PersistentSegmentTree<T, StatsPolicy>::PersistentSegmentTree(std::vector<T> vect) {
 	size_t size_ = vect.size();
 	static size_t count = 0;
 
@@ -79,38 +83,46 @@ PersistentSegmentTree<T>::PersistentSegmentTree<T>(std::vector<T> vect) {
 	this->size = 2 * size_ - 1;
 
 	head = new Node<T>(0, (size + 1) / 2 - 1, 0);
+	this->Allocate();
 	MakeNodes(head, vect);
 	versions.push_back(head);
+	this->Version();
 
 }
 
 
-template <class T>
-void PersistentSegmentTree<T>::UpdateElement(size_t position, T value) {
+template <class T, class StatsPolicy>
+void PersistentSegmentTree<T, StatsPolicy>::UpdateElement(size_t position, T value) {
+	typename StatsPolicy::Scope scope(*this, true);
 	Node<T>* next_version_head = new Node<T>(head->tl, head->tr, head->sum);
+	this->Allocate();
 	next_version_head->sum += value;
 	UpdateElement(position, value, 0, (size + 1) / 2 - 1, head, next_version_head);
 	head = next_version_head;
 	versions.push_back(next_version_head);
+	this->Version();
 }
 
 
 /*
     ,    
     = new Node<T>,    */
-template <class T>
-void PersistentSegmentTree<T>::UpdateElement(size_t position, T value, size_t tl, size_t tr, Node<T>* cur_pos, Node<T>* next_version_pos) {
+template <class T, class StatsPolicy>
+void PersistentSegmentTree<T, StatsPolicy>::UpdateElement(size_t position, T value, size_t tl, size_t tr, Node<T>* cur_pos, Node<T>* next_version_pos) {
+	this->Visit();
 	if (tl == tr) {
 		return;
 	}
 	size_t mid = (tl + tr) / 2 + 1;
 	if (position < mid) {
 		next_version_pos->left = new Node<T>(tl, mid - 1, cur_pos->left->sum + value);
+		this->Allocate();
 		next_version_pos->right = cur_pos->right;
 		UpdateElement(position, value, tl, mid - 1, cur_pos->left, next_version_pos->left);
 	}
 	else {
 		next_version_pos->right = new Node<T>(mid, tr, cur_pos->right->sum + value);
+		this->Allocate();
 		//next_version_pos->right->sum += value;
 		next_version_pos->left = cur_pos->left;
 		UpdateElement(position, value, mid, tr, cur_pos->right, next_version_pos->right);
@@ -122,15 +134,17 @@ void PersistentSegmentTree<T>::UpdateElement(size_t position, T value, size_t tl
 ,       ,   
     ,    .
 */
-template <class T>
-T PersistentSegmentTree<T>::GetSum(size_t left, size_t right, size_t version) {
+template <class T, class StatsPolicy>
+T PersistentSegmentTree<T, StatsPolicy>::GetSum(size_t left, size_t right, size_t version) {
+	typename StatsPolicy::Scope scope(*this, false);
 	if (!head) return 0;
 	return GetSum(left, right, versions[version]);
 }
 
 
-template <class T>
-T PersistentSegmentTree<T>::GetSum(size_t left, size_t right, Node<T>* cur_pos) {
+template <class T, class StatsPolicy>
+T PersistentSegmentTree<T, StatsPolicy>::GetSum(size_t left, size_t right, Node<T>* cur_pos) {
+	this->Visit();
 	if (cur_pos->tl == cur_pos->tr)
 		return cur_pos->sum;
 
@@ -146,9 +160,9 @@ T PersistentSegmentTree<T>::GetSum(size_t left, size_t right, Node<T>* cur_pos)
 	return sum;
 }
 
-template <class T>
-PersistentSegmentTree<T>::~PersistentSegmentTree() {
-	head->clear();
+template <class T, class StatsPolicy>
+PersistentSegmentTree<T, StatsPolicy>::~PersistentSegmentTree() {
+	this->Release(head->clear() + 1);
 	if (head)
 		delete head;
 }
\ No newline at end of file
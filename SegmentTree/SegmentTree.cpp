@@ -4,8 +4,27 @@
 
 //#include "SegmentTree.hpp"
 #include "PersistentSegmentTree.hpp"
+#include "SlidingWindowSegmentTree.hpp"
+#include "SegmentTree2D.hpp"
+#include "FenwickTree.hpp"
+#include "SegmentTreeBeats.hpp"
+#include "FixedSegmentTree.hpp"
 
 
+int failed = 0;
+
+/*
+prints the value a test got and counts it as failed if it is not the expected one
+*/
+void Check(const char* name, long long value, long long expected) {
+	std::cout << name << " " << value;
+	if (value != expected) {
+		std::cout << " expected " << expected;
+		++failed;
+	}
+	std::cout << "\n";
+}
+
 void test1() {
 	std::vector<int> vect;
 	for (int i = 0; i < 6; ++i) {
@@ -50,7 +69,138 @@ void test3() {
 	delete tree;
 }
 
+void test4() {
+	SlidingWindowSegmentTree<int>* tree = new SlidingWindowSegmentTree<int>(3);
+	for (int i = 1; i <= 5; ++i)
+		tree->Push(i);
+	//window is {3, 4, 5}
+	Check("test4 window", tree->GetWindowSum(), 12);
+	Check("test4 newest two", tree->GetSum(1, 2), 9);
+
+	delete tree;
+}
+
+void test5() {
+	std::vector<int> vect(3, 1);
+	SegmentTree<int>* tree = new SegmentTree<int>(vect);
+	for (int i = 0; i < 6; ++i)
+		tree->PushBack(i);
+	//capacity grew 4 -> 8 -> 16 without rebuilding
+	Check("test5 sum", tree->GetSum(0, tree->Count() - 1), 18);
+	Check("test5 capacity", tree->Capacity(), 16);
+
+	delete tree;
+}
+
+void test6() {
+	std::vector<std::pair<size_t, size_t>> points = { {0, 0}, {3, 5}, {7, 2}, {1000000, 1000000} };
+	SegmentTree2D<int>* tree = new SegmentTree2D<int>(points);
+	tree->UpdateElement(0, 0, 1);
+	tree->UpdateElement(3, 5, 2);
+	tree->UpdateElement(7, 2, 4);
+	tree->UpdateElement(1000000, 1000000, 8);
+
+	Check("test6 lower", tree->GetSum(0, 7, 0, 4), 5);
+	Check("test6 upper", tree->GetSum(3, 1000000, 2, 1000000), 14);
+
+	delete tree;
+}
+
+void test7() {
+	const int n = 16;
+	std::vector<int> vect(n, 1);
+	SegmentTree<int>* tree = new SegmentTree<int>(vect);
+	FenwickTree<int>* fenwick = new FenwickTree<int>(vect);
+	Check("test7 min", fenwick->GetMin(0, 10), 9);
+
+	int mismatches = 0;
+	for (int i = 0; i < 4 * n; ++i) {
+		tree->SetElement(i * 7 % n, i % 5);
+		fenwick->SetElement(i * 7 % n, i % 5);
+		if (tree->GetSum(i * 3 % n / 2, n / 2 + i * 11 % (n / 2)) != fenwick->GetSum(i * 3 % n / 2, n / 2 + i * 11 % (n / 2)))
+			++mismatches;
+	}//both trees have to answer the same
+	Check("test7 mismatches", mismatches, 0);
+
+	RangeFenwickTree<int>* range = new RangeFenwickTree<int>(vect);
+	range->UpdateRange(2, 5, 10);
+	Check("test7 range", range->GetSum(0, 3), 24);
+
+	delete range;
+	delete fenwick;
+	delete tree;
+}
+
+void test8() {
+	std::vector<int> vect = { 5, 1, 7, 3, 9, 2 };
+	SegmentTreeBeats<int>* tree = new SegmentTreeBeats<int>(vect);
+	tree->RangeChmin(0, 5, 4);//{4, 1, 4, 3, 4, 2}
+	tree->RangeChmax(1, 3, 2);//{4, 2, 4, 3, 4, 2}
+	tree->RangeAdd(4, 5, 1);//{4, 2, 4, 3, 5, 3}
+
+	Check("test8 sum", tree->GetSum(0, 5), 21);
+	Check("test8 maximum", tree->GetMaximum(0, 5), 5);
+	Check("test8 minimum", tree->GetMinimum(2, 5), 3);
+
+	delete tree;
+}
+
+void test9() {
+	DynamicSegmentTree<int>* first = new DynamicSegmentTree<int>(16);
+	DynamicSegmentTree<int>* second = new DynamicSegmentTree<int>(16);
+	first->UpdateElement(1, 1);
+	first->UpdateElement(9, 9);
+	second->UpdateElement(9, 10);
+	second->UpdateElement(14, 14);
+
+	first->Merge(*second);//first = {1: 1, 9: 19, 14: 14}, second is empty
+	DynamicSegmentTree<int>* right = first->Split(8);
+
+	Check("test9 left", first->GetSum(0, 15), 1);
+	Check("test9 right", right->GetSum(0, 15), 33);
+	Check("test9 merged", second->GetSum(0, 15), 0);
+
+	delete right;
+	delete second;
+	delete first;
+}
+
+void test10() {
+	constexpr FixedSegmentTree<int, 6> tree(std::array<int, 6>{ 5, 1, 1, 3, 3, 0 });
+	static_assert(tree.GetSum(1, 4) == 8, "built at compile time");
+
+	FixedSegmentTree<int, 64> trees[4];//no heap, one contiguous block
+	trees[2].SetElement(10, 7);
+	Check("test10 min", tree.GetMin(0, 7), 2);
+	Check("test10 sum", trees[2].GetSum(0, 63), 7);
+}
+
+void test11() {
+	std::vector<std::pair<size_t, int>> sorted = { {0, 0}, {1, 1}, {2, 2}, {3, 3}, {6, 6} };
+	DynamicSegmentTree<int>* tree = DynamicSegmentTree<int>::FromSorted(sorted.begin(), sorted.end(), 9);
+	CompressedTree<int> comp(sorted.begin(), sorted.end());
+
+	//same tree as in test2
+	Check("test11 dynamic", tree->GetSum(0, 6), 12);
+	Check("test11 compressed", comp.GetSum(0, 6), 12);
+
+	delete tree;
+}
+
 int main()
 {
 	test1();
+	std::cout << "\n";
+	test2();
+	std::cout << "\n";
+	test3();
+	test4();
+	test5();
+	test6();
+	test7();
+	test8();
+	test9();
+	test10();
+	test11();
+	return failed ? 1 : 0;
 }
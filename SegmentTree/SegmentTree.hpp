@@ -1,12 +1,17 @@
+#pragma once
 #include <vector>
 #include <cstddef>
+#include <algorithm>
+#include <cmath>
 
 template <class T>
 class SegmentTree {
 private:
 	size_t size;
+	size_t count;
 	std::vector<T> array;
 
+	void FixUp(size_t position);
 	T GetSum(int position, int tl, int tr, int l, int r);
 	T GetMin(int left, T sum, int position, int tl, int tr, T cur_sum);
 public:
@@ -14,6 +19,12 @@ public:
 
 	void SetElement(size_t position, T value);
 
+	void PushBack(T value);
+	void Reserve(size_t capacity);
+
+	size_t Count() { return count; }
+	size_t Capacity() { return (size + 1) / 2; }
+
 	T GetSum(int left, int right);
 	T GetMin(int left, T sum);
 
@@ -46,8 +57,9 @@ size_t findk(size_t len) {//this function takes number and finds int k, that sat
 }
 
 template <class T>
-SegmentTree<T>::SegmentTree<T>(std::vector<T> vect) {
+SegmentTree<T>::SegmentTree(std::vector<T> vect) {
 	size_t size_ = vect.size();
+	this->count = size_;
 	size_ = std::pow(2, findk(size_));
 	vect.resize(size_);
 
@@ -71,6 +83,64 @@ void SegmentTree<T>::SetElement(size_t position, T value) {
 	}
 }
 
+/*
+recomputes sums on the path from the node at position up to the root
+*/
+template <class T>
+void SegmentTree<T>::FixUp(size_t position) {
+	while (position) {
+		position = (position - 1) / 2;
+		this->array[position] = this->array[2 * position + 1] + this->array[2 * position + 2];
+	}
+}
+
+/*
+appends value after the last element, doubling capacity when the tree is full
+*/
+template <class T>
+void SegmentTree<T>::PushBack(T value) {
+	if (count == (size + 1) / 2)
+		Reserve(2 * count);
+	size_t position = (size + 1) / 2 - 1 + count;
+	this->array[position] = value;
+	++count;
+	FixUp(position);
+}
+
+/*
+Grows capacity to at least `capacity` leaves without recomputing any sums. The old tree becomes the
+leftmost subtree of the new one: every old level d is moved as one block to level d + shift, the new
+levels above it hold the old root sum on their leftmost node, everything else is zero.
+In the flat layout the old levels can not stay in place, but each one is a single sequential copy.
+*/
+template <class T>
+void SegmentTree<T>::Reserve(size_t capacity) {
+	size_t old_size_ = (size + 1) / 2;
+	if (capacity <= old_size_)
+		return;
+	size_t size_ = std::pow(2, findk(capacity));
+	size_t old_levels = findk(old_size_) + 1;
+	size_t shift = findk(size_) - findk(old_size_);
+	T root = this->array[0];
+
+	this->size = 2 * size_ - 1;
+	this->array.resize(this->size, T(0));
+
+	for (size_t d = old_levels; d-- > 0;) {
+		size_t width = (size_t)1 << d;
+		std::copy(this->array.begin() + (width - 1), this->array.begin() + (2 * width - 1),
+			this->array.begin() + ((width << shift) - 1));
+	}//deepest level first, so no block is overwritten before it is moved
+
+	for (size_t k = 0; k < old_levels + shift; ++k) {
+		size_t width = (size_t)1 << k;
+		size_t used = k < shift ? 1 : width >> shift;
+		if (k < shift)
+			this->array[width - 1] = root;
+		std::fill(this->array.begin() + (width - 1 + used), this->array.begin() + (2 * width - 1), T(0));
+	}
+}
+
 template <class T>
 T SegmentTree<T>::GetSum(int left, int right) {
 	if (left < 0 || right >= (size + 1) / 2 || right < left)
@@ -83,7 +153,7 @@ T SegmentTree<T>::GetSum(int position, int tl, int tr, int l, int r) {
 	if (tl >= l && tr <= r)
 		return array[position];
 	int mid = (tl + tr) / 2 + 1;
-	int ans = 0;
+	T ans = T(0);
 	if (l < mid) {
 		ans += GetSum(position * 2 + 1, tl, mid - 1, l, std::min(r, mid - 1));
 
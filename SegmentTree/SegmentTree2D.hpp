@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+
+#include "SegmentTree.hpp"
+#include "FenwickTree.hpp"
+
+/*
+Two-dimensional segment tree over points known in advance. The outer tree is the same flat
+tree as in SegmentTree, built over the sorted distinct x of the points. Every node keeps, like
+SegmentTreeWithValues, the sorted distinct y of the points in its x-range, and a FenwickTree
+over those y. So memory is O(points * log points) and does not depend on the grid area.
+
+UpdateElement(x, y, value) means a[x][y] += value, (x, y) has to be one of the points given
+to the constructor. Both operations are O(log^2 n).
+*/
+template <class T>
+class SegmentTree2D {
+private:
+	size_t size;
+	std::vector<size_t> xs;
+	std::vector<std::vector<size_t>> ys;
+	std::vector<FenwickTree<T>> bits;
+
+	T GetSum(size_t position, size_t tl, size_t tr, size_t l, size_t r, size_t bottom, size_t top);
+public:
+	explicit SegmentTree2D<T>(std::vector<std::pair<size_t, size_t>> points);
+
+	void UpdateElement(size_t x, size_t y, T value);
+
+	T GetSum(size_t left, size_t right, size_t bottom, size_t top);
+
+	~SegmentTree2D<T>() {}
+};
+
+template <class T>
+SegmentTree2D<T>::SegmentTree2D(std::vector<std::pair<size_t, size_t>> points) {
+	std::sort(points.begin(), points.end());
+	points.erase(std::unique(points.begin(), points.end()), points.end());
+
+	for (size_t i = 0; i < points.size(); ++i) {
+		if (xs.empty() || xs.back() != points[i].first)
+			xs.push_back(points[i].first);
+	}
+
+	size_t size_ = std::pow(2, findk(xs.size()));
+	this->size = 2 * size_ - 1;
+	this->ys.resize(this->size);
+
+	size_t leaf = 0;
+	for (size_t i = 0; i < points.size(); ++i) {
+		if (points[i].first != xs[leaf])
+			++leaf;
+		this->ys[size_ - 1 + leaf].push_back(points[i].second);
+	}//points are sorted, so y in every leaf are sorted and distinct
+
+	for (int i = size_ - 2; i >= 0; --i) {
+		std::merge(ys[2 * i + 1].begin(), ys[2 * i + 1].end(), ys[2 * i + 2].begin(), ys[2 * i + 2].end(),
+			std::back_inserter(ys[i]));
+		ys[i].erase(std::unique(ys[i].begin(), ys[i].end()), ys[i].end());
+	}
+
+	this->bits.reserve(this->size);
+	for (size_t i = 0; i < this->size; ++i) {
+		bits.emplace_back(std::vector<T>(ys[i].size(), T(0)));
+	}
+}
+
+template <class T>
+void SegmentTree2D<T>::UpdateElement(size_t x, size_t y, T value) {
+	auto it = std::lower_bound(xs.begin(), xs.end(), x);
+	if (it == xs.end() || *it != x)
+		throw 'e';
+	size_t position = (size + 1) / 2 - 1 + (it - xs.begin());
+
+	while (true) {
+		auto jt = std::lower_bound(ys[position].begin(), ys[position].end(), y);
+		if (jt == ys[position].end() || *jt != y)
+			throw 'e';
+		bits[position].UpdateElement(jt - ys[position].begin(), value);
+		if (!position) break;
+		position = (position - 1) / 2;
+	}
+}
+
+/*
+sum over the rectangle [left, right] x [bottom, top], bounds are coordinates, not point indices
+*/
+template <class T>
+T SegmentTree2D<T>::GetSum(size_t left, size_t right, size_t bottom, size_t top) {
+	if (right < left || top < bottom)
+		throw 'e';
+	size_t l = std::lower_bound(xs.begin(), xs.end(), left) - xs.begin();
+	size_t r = std::upper_bound(xs.begin(), xs.end(), right) - xs.begin();
+	if (l >= r)
+		return T(0);
+	return GetSum(0, 0, (size + 1) / 2 - 1, l, r - 1, bottom, top);
+}
+
+template <class T>
+T SegmentTree2D<T>::GetSum(size_t position, size_t tl, size_t tr, size_t l, size_t r, size_t bottom, size_t top) {
+	if (tl >= l && tr <= r) {
+		size_t from = std::lower_bound(ys[position].begin(), ys[position].end(), bottom) - ys[position].begin();
+		size_t to = std::upper_bound(ys[position].begin(), ys[position].end(), top) - ys[position].begin();
+		if (from >= to)
+			return T(0);
+		return bits[position].GetSum(from, to - 1);
+	}
+	size_t mid = (tl + tr) / 2 + 1;
+	T ans = T(0);
+	if (l < mid) {
+		ans += GetSum(position * 2 + 1, tl, mid - 1, l, std::min(r, mid - 1), bottom, top);
+	}
+	if (r >= mid) {
+		ans += GetSum(position * 2 + 2, mid, tr, std::max(l, mid), r, bottom, top);
+	}
+	return ans;
+}
@@ -0,0 +1,358 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+
+#include "SegmentTree.hpp"
+
+template <class T>
+class BeatsNode_ {
+private:
+	T sum;
+	T max1;
+	T max2;
+	size_t max_count;
+	T min1;
+	T min2;
+	size_t min_count;
+	T lazy;
+public:
+	explicit BeatsNode_<T>() : sum(0), max1(0), max2(0), max_count(0), min1(0), min2(0), min_count(0), lazy(0) {}
+
+	~BeatsNode_<T>() {}
+
+	template <class U>
+	friend class SegmentTreeBeats;
+};
+
+/*
+Segment tree beats: besides range add it supports a[i] = min(a[i], x) and a[i] = max(a[i], x) on a range,
+with range sum, maximum and minimum queries. Every node keeps the maximum, the second maximum and how many
+times the maximum occurs (and the same for the minimum). A chmin that is between the maximum and the second
+maximum only changes the maximum of the node, so it is applied without going down; otherwise the tree goes
+deeper. All operations are amortized O(log^2 n).
+
+The nodes are stored in the same flat layout as SegmentTree, the recursion runs over [0, count - 1],
+so the padded leaves are never visited.
+*/
+template <class T>
+class SegmentTreeBeats {
+private:
+	size_t size;
+	size_t count;
+	std::vector<BeatsNode_<T>> nodes;
+
+	void Build(std::vector<T>& vect, size_t position, size_t tl, size_t tr);
+	void PullUp(size_t position);
+	void PushDown(size_t position, size_t tl, size_t tr);
+
+	void ApplyAdd(size_t position, size_t length, T value);
+	void ApplyMin(size_t position, T value);
+	void ApplyMax(size_t position, T value);
+
+	void RangeChmin(size_t left, size_t right, T value, size_t position, size_t tl, size_t tr);
+	void RangeChmax(size_t left, size_t right, T value, size_t position, size_t tl, size_t tr);
+	void RangeAdd(size_t left, size_t right, T value, size_t position, size_t tl, size_t tr);
+
+	T GetSum(size_t left, size_t right, size_t position, size_t tl, size_t tr);
+	T GetMaximum(size_t left, size_t right, size_t position, size_t tl, size_t tr);
+	T GetMinimum(size_t left, size_t right, size_t position, size_t tl, size_t tr);
+public:
+	explicit SegmentTreeBeats<T>(std::vector<T> vect);
+
+	void RangeChmin(size_t left, size_t right, T value);
+	void RangeChmax(size_t left, size_t right, T value);
+	void RangeAdd(size_t left, size_t right, T value);
+
+	T GetSum(size_t left, size_t right);
+	T GetMaximum(size_t left, size_t right);
+	T GetMinimum(size_t left, size_t right);
+
+	~SegmentTreeBeats<T>() {}
+};
+
+template <class T>
+SegmentTreeBeats<T>::SegmentTreeBeats(std::vector<T> vect) {
+	size_t size_ = vect.size();
+	this->count = size_;
+	size_ = std::pow(2, findk(size_));
+
+	this->size = 2 * size_ - 1;
+	this->nodes.resize(this->size);
+	if (count)
+		Build(vect, 0, 0, count - 1);
+}
+
+template <class T>
+void SegmentTreeBeats<T>::Build(std::vector<T>& vect, size_t position, size_t tl, size_t tr) {
+	if (tl == tr) {
+		BeatsNode_<T>& node = nodes[position];
+		node.sum = node.max1 = node.min1 = vect[tl];
+		node.max2 = std::numeric_limits<T>::lowest();
+		node.min2 = std::numeric_limits<T>::max();
+		node.max_count = node.min_count = 1;
+		return;
+	}
+	size_t mid = (tl + tr) / 2 + 1;
+	Build(vect, 2 * position + 1, tl, mid - 1);
+	Build(vect, 2 * position + 2, mid, tr);
+	PullUp(position);
+}
+
+template <class T>
+void SegmentTreeBeats<T>::PullUp(size_t position) {
+	BeatsNode_<T>& node = nodes[position];
+	BeatsNode_<T>& left = nodes[2 * position + 1];
+	BeatsNode_<T>& right = nodes[2 * position + 2];
+
+	node.sum = left.sum + right.sum;
+
+	if (left.max1 == right.max1) {
+		node.max1 = left.max1;
+		node.max2 = std::max(left.max2, right.max2);
+		node.max_count = left.max_count + right.max_count;
+	}
+	else if (left.max1 > right.max1) {
+		node.max1 = left.max1;
+		node.max2 = std::max(left.max2, right.max1);
+		node.max_count = left.max_count;
+	}
+	else {
+		node.max1 = right.max1;
+		node.max2 = std::max(left.max1, right.max2);
+		node.max_count = right.max_count;
+	}
+
+	if (left.min1 == right.min1) {
+		node.min1 = left.min1;
+		node.min2 = std::min(left.min2, right.min2);
+		node.min_count = left.min_count + right.min_count;
+	}
+	else if (left.min1 < right.min1) {
+		node.min1 = left.min1;
+		node.min2 = std::min(left.min2, right.min1);
+		node.min_count = left.min_count;
+	}
+	else {
+		node.min1 = right.min1;
+		node.min2 = std::min(left.min1, right.min2);
+		node.min_count = right.min_count;
+	}
+}
+
+template <class T>
+void SegmentTreeBeats<T>::ApplyAdd(size_t position, size_t length, T value) {
+	BeatsNode_<T>& node = nodes[position];
+	node.sum += value * T(length);
+	node.max1 += value;
+	if (node.max2 != std::numeric_limits<T>::lowest())
+		node.max2 += value;
+	node.min1 += value;
+	if (node.min2 != std::numeric_limits<T>::max())
+		node.min2 += value;
+	node.lazy += value;
+}
+
+/*
+value has to satisfy max2 < value < max1, then only the maximums of the node change
+*/
+template <class T>
+void SegmentTreeBeats<T>::ApplyMin(size_t position, T value) {
+	BeatsNode_<T>& node = nodes[position];
+	node.sum -= (node.max1 - value) * T(node.max_count);
+	if (node.min1 == node.max1)
+		node.min1 = value;
+	else if (node.min2 == node.max1)
+		node.min2 = value;
+	node.max1 = value;
+}
+
+template <class T>
+void SegmentTreeBeats<T>::ApplyMax(size_t position, T value) {
+	BeatsNode_<T>& node = nodes[position];
+	node.sum += (value - node.min1) * T(node.min_count);
+	if (node.max1 == node.min1)
+		node.max1 = value;
+	else if (node.max2 == node.min1)
+		node.max2 = value;
+	node.min1 = value;
+}
+
+/*
+passes the pending add and the clamps of the node to its children
+*/
+template <class T>
+void SegmentTreeBeats<T>::PushDown(size_t position, size_t tl, size_t tr) {
+	size_t mid = (tl + tr) / 2 + 1;
+	size_t left = 2 * position + 1;
+	size_t right = 2 * position + 2;
+
+	if (nodes[position].lazy != T(0)) {
+		ApplyAdd(left, mid - tl, nodes[position].lazy);
+		ApplyAdd(right, tr - mid + 1, nodes[position].lazy);
+		nodes[position].lazy = T(0);
+	}
+	if (nodes[left].max1 > nodes[position].max1)
+		ApplyMin(left, nodes[position].max1);
+	if (nodes[right].max1 > nodes[position].max1)
+		ApplyMin(right, nodes[position].max1);
+	if (nodes[left].min1 < nodes[position].min1)
+		ApplyMax(left, nodes[position].min1);
+	if (nodes[right].min1 < nodes[position].min1)
+		ApplyMax(right, nodes[position].min1);
+}
+
+/*
+a[i] = min(a[i], value) for every i in [left, right]
+*/
+template <class T>
+void SegmentTreeBeats<T>::RangeChmin(size_t left, size_t right, T value) {
+	if (right >= count || right < left)
+		throw 'e';
+	RangeChmin(left, right, value, 0, 0, count - 1);
+}
+
+template <class T>
+void SegmentTreeBeats<T>::RangeChmin(size_t left, size_t right, T value, size_t position, size_t tl, size_t tr) {
+	if (nodes[position].max1 <= value)
+		return;
+	if (tl >= left && tr <= right && nodes[position].max2 < value) {
+		ApplyMin(position, value);
+		return;
+	}
+	PushDown(position, tl, tr);
+	size_t mid = (tl + tr) / 2 + 1;
+	if (left < mid) {
+		RangeChmin(left, std::min(right, mid - 1), value, 2 * position + 1, tl, mid - 1);
+	}
+	if (right >= mid) {
+		RangeChmin(std::max(left, mid), right, value, 2 * position + 2, mid, tr);
+	}
+	PullUp(position);
+}
+
+/*
+a[i] = max(a[i], value) for every i in [left, right]
+*/
+template <class T>
+void SegmentTreeBeats<T>::RangeChmax(size_t left, size_t right, T value) {
+	if (right >= count || right < left)
+		throw 'e';
+	RangeChmax(left, right, value, 0, 0, count - 1);
+}
+
+template <class T>
+void SegmentTreeBeats<T>::RangeChmax(size_t left, size_t right, T value, size_t position, size_t tl, size_t tr) {
+	if (nodes[position].min1 >= value)
+		return;
+	if (tl >= left && tr <= right && nodes[position].min2 > value) {
+		ApplyMax(position, value);
+		return;
+	}
+	PushDown(position, tl, tr);
+	size_t mid = (tl + tr) / 2 + 1;
+	if (left < mid) {
+		RangeChmax(left, std::min(right, mid - 1), value, 2 * position + 1, tl, mid - 1);
+	}
+	if (right >= mid) {
+		RangeChmax(std::max(left, mid), right, value, 2 * position + 2, mid, tr);
+	}
+	PullUp(position);
+}
+
+/*
+a[i] += value for every i in [left, right]
+*/
+template <class T>
+void SegmentTreeBeats<T>::RangeAdd(size_t left, size_t right, T value) {
+	if (right >= count || right < left)
+		throw 'e';
+	RangeAdd(left, right, value, 0, 0, count - 1);
+}
+
+template <class T>
+void SegmentTreeBeats<T>::RangeAdd(size_t left, size_t right, T value, size_t position, size_t tl, size_t tr) {
+	if (tl >= left && tr <= right) {
+		ApplyAdd(position, tr - tl + 1, value);
+		return;
+	}
+	PushDown(position, tl, tr);
+	size_t mid = (tl + tr) / 2 + 1;
+	if (left < mid) {
+		RangeAdd(left, std::min(right, mid - 1), value, 2 * position + 1, tl, mid - 1);
+	}
+	if (right >= mid) {
+		RangeAdd(std::max(left, mid), right, value, 2 * position + 2, mid, tr);
+	}
+	PullUp(position);
+}
+
+template <class T>
+T SegmentTreeBeats<T>::GetSum(size_t left, size_t right) {
+	if (right >= count || right < left)
+		throw 'e';
+	return GetSum(left, right, 0, 0, count - 1);
+}
+
+template <class T>
+T SegmentTreeBeats<T>::GetSum(size_t left, size_t right, size_t position, size_t tl, size_t tr) {
+	if (tl >= left && tr <= right)
+		return nodes[position].sum;
+	PushDown(position, tl, tr);
+	size_t mid = (tl + tr) / 2 + 1;
+	T sum = T(0);
+	if (left < mid) {
+		sum += GetSum(left, std::min(right, mid - 1), 2 * position + 1, tl, mid - 1);
+	}
+	if (right >= mid) {
+		sum += GetSum(std::max(left, mid), right, 2 * position + 2, mid, tr);
+	}
+	return sum;
+}
+
+template <class T>
+T SegmentTreeBeats<T>::GetMaximum(size_t left, size_t right) {
+	if (right >= count || right < left)
+		throw 'e';
+	return GetMaximum(left, right, 0, 0, count - 1);
+}
+
+template <class T>
+T SegmentTreeBeats<T>::GetMaximum(size_t left, size_t right, size_t position, size_t tl, size_t tr) {
+	if (tl >= left && tr <= right)
+		return nodes[position].max1;
+	PushDown(position, tl, tr);
+	size_t mid = (tl + tr) / 2 + 1;
+	T ans = std::numeric_limits<T>::lowest();
+	if (left < mid) {
+		ans = std::max(ans, GetMaximum(left, std::min(right, mid - 1), 2 * position + 1, tl, mid - 1));
+	}
+	if (right >= mid) {
+		ans = std::max(ans, GetMaximum(std::max(left, mid), right, 2 * position + 2, mid, tr));
+	}
+	return ans;
+}
+
+template <class T>
+T SegmentTreeBeats<T>::GetMinimum(size_t left, size_t right) {
+	if (right >= count || right < left)
+		throw 'e';
+	return GetMinimum(left, right, 0, 0, count - 1);
+}
+
+template <class T>
+T SegmentTreeBeats<T>::GetMinimum(size_t left, size_t right, size_t position, size_t tl, size_t tr) {
+	if (tl >= left && tr <= right)
+		return nodes[position].min1;
+	PushDown(position, tl, tr);
+	size_t mid = (tl + tr) / 2 + 1;
+	T ans = std::numeric_limits<T>::max();
+	if (left < mid) {
+		ans = std::min(ans, GetMinimum(left, std::min(right, mid - 1), 2 * position + 1, tl, mid - 1));
+	}
+	if (right >= mid) {
+		ans = std::min(ans, GetMinimum(std::max(left, mid), right, 2 * position + 2, mid, tr));
+	}
+	return ans;
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(SEGMENT_TREE_STATS_PERF) && defined(__linux__)
+#include <cstring>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/*
+Stats policies for the pointer trees. A tree inherits its policy privately and calls Visit, SearchStep,
+Allocate, Release and Version on the hot path; every public operation opens a Scope. With NoStats all of these
+are empty inline functions and the base is empty, so a tree without stats costs nothing.
+
+The default policy of DynamicSegmentTree, PersistentSegmentTree and SegmentTreeWithValues is chosen at
+compile time:
+	SEGMENT_TREE_STATS       - CountingStats, plain counters
+	SEGMENT_TREE_STATS_PERF  - PerfStats, counters plus cycles and cache misses (PERF_COUNT_HW_CACHE_MISSES,
+	                           last level cache on most CPUs) from perf_event on Linux, read around every
+	                           SEGMENT_TREE_STATS_PERF_PERIOD-th operation
+A policy can also be passed explicitly, e.g. DynamicSegmentTree<int, CountingStats>. PerfStats and the
+perf_event headers are only compiled with SEGMENT_TREE_STATS_PERF.
+
+allocations counts every node ever created, live_nodes the nodes the tree holds right now. When nodes
+move to another tree (DynamicSegmentTree::Merge and Split) Transfer moves them between the live_nodes of
+the two trees; CountsNodes tells the tree whether it has to count the moved nodes at all.
+*/
+struct TreeStats {
+	size_t queries;
+	size_t updates;
+	size_t nodes_visited;
+	size_t search_steps;
+	size_t allocations;
+	size_t live_nodes;
+	size_t versions;
+	uint64_t cycles;
+	uint64_t llc_misses;
+	size_t perf_samples;
+
+	TreeStats() : queries(0), updates(0), nodes_visited(0), search_steps(0), allocations(0),
+		live_nodes(0), versions(0), cycles(0), llc_misses(0), perf_samples(0) {}
+};
+
+class NoStats {
+protected:
+	void Visit() {}
+	void SearchStep() {}
+	void Allocate() {}
+	void Release(size_t = 1) {}
+	void Transfer(NoStats&, size_t) {}
+	void Version() {}
+
+	static const bool CountsNodes = false;
+
+	struct Scope {
+		Scope(NoStats&, bool) {}
+	};
+public:
+	TreeStats Stats() const { return TreeStats(); }
+};
+
+class CountingStats {
+protected:
+	TreeStats stats;
+	size_t depth;
+
+	void Visit() { ++stats.nodes_visited; }
+	void SearchStep() { ++stats.search_steps; }
+	void Allocate() { ++stats.allocations; ++stats.live_nodes; }
+	void Release(size_t count = 1) { stats.live_nodes -= count; }
+	void Transfer(CountingStats& to, size_t count) { stats.live_nodes -= count; to.stats.live_nodes += count; }
+	void Version() { ++stats.versions; }
+
+	static const bool CountsNodes = true;
+
+	/*
+	public operations call each other (SetElement -> IsExist -> UpdateElement), only the outermost one is counted
+	*/
+	struct Scope {
+		CountingStats& owner;
+		Scope(CountingStats& owner, bool update) : owner(owner) {
+			if (!owner.depth++) {
+				if (update) ++owner.stats.updates;
+				else ++owner.stats.queries;
+			}
+		}
+		~Scope() { --owner.depth; }
+	};
+public:
+	CountingStats() : depth(0) {}
+
+	TreeStats Stats() const { return stats; }
+};
+
+#if defined(SEGMENT_TREE_STATS_PERF)
+
+#ifndef SEGMENT_TREE_STATS_PERF_PERIOD
+#define SEGMENT_TREE_STATS_PERF_PERIOD 64
+#endif
+
+/*
+perf_event counts the calling thread, so the two counters are opened once per thread and shared by
+every tree used on it. Opening them per tree would cost two descriptors for every tree.
+*/
+class PerfStats : public CountingStats {
+protected:
+	struct Counters {
+		int cycles_fd;
+		int llc_fd;
+
+		Counters() : cycles_fd(-1), llc_fd(-1) {
+#if defined(__linux__)
+			cycles_fd = Open(PERF_COUNT_HW_CPU_CYCLES);
+			llc_fd = Open(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+		}
+		Counters(const Counters&) = delete;
+		Counters& operator=(const Counters&) = delete;
+
+		~Counters() {
+#if defined(__linux__)
+			if (cycles_fd >= 0) close(cycles_fd);
+			if (llc_fd >= 0) close(llc_fd);
+#endif
+		}
+	};
+
+	uint64_t cycles_start;
+	uint64_t llc_start;
+	bool sampling;
+
+	static Counters& Shared() {
+		thread_local Counters counters;
+		return counters;
+	}
+
+	static int Open(uint64_t config) {
+#if defined(__linux__)
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+		(void)config;
+		return -1;
+#endif
+	}
+
+	static uint64_t Read(int fd) {
+		uint64_t value = 0;
+#if defined(__linux__)
+		if (fd >= 0 && read(fd, &value, sizeof(value)) != sizeof(value))
+			value = 0;
+#else
+		(void)fd;
+#endif
+		return value;
+	}
+
+	void Begin() {
+		sampling = stats.queries + stats.updates == 1 ||
+			(stats.queries + stats.updates) % SEGMENT_TREE_STATS_PERF_PERIOD == 0;
+		Counters& counters = Shared();
+		if (!sampling || counters.cycles_fd < 0)
+			return;
+		cycles_start = Read(counters.cycles_fd);
+		llc_start = Read(counters.llc_fd);
+	}
+
+	void End() {
+		Counters& counters = Shared();
+		if (!sampling || counters.cycles_fd < 0)
+			return;
+		stats.cycles += Read(counters.cycles_fd) - cycles_start;
+		stats.llc_misses += Read(counters.llc_fd) - llc_start;
+		++stats.perf_samples;
+	}
+
+	struct Scope {
+		CountingStats::Scope counting;
+		PerfStats& owner;
+		Scope(PerfStats& owner, bool update) : counting(owner, update), owner(owner) {
+			if (owner.depth == 1) owner.Begin();
+		}
+		~Scope() {
+			if (owner.depth == 1) owner.End();
+		}
+	};
+public:
+	PerfStats() : cycles_start(0), llc_start(0), sampling(false) {}
+};
+
+typedef PerfStats DefaultStats;
+#elif defined(SEGMENT_TREE_STATS)
+typedef CountingStats DefaultStats;
+#else
+typedef NoStats DefaultStats;
+#endif
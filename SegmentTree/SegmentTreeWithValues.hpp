@@ -1,6 +1,8 @@
+#pragma once
 #include <vector>
 #include <cstddef>
 #include "SegmentTree.hpp"
+#include "SegmentTreeStats.hpp"
 
 template <class T>
 class Node_ {
@@ -14,13 +16,13 @@ public:
 
 	~Node_<T>() {}
 
-	template <class T>
+	template <class U, class S>
 	friend class SegmentTreeWithValues;
 
 };
 
-template <class T>
-class SegmentTreeWithValues {
+template <class T, class StatsPolicy = DefaultStats>
+class SegmentTreeWithValues : private StatsPolicy {
 private:
 	std::vector<Node_<T>*> nodes;
 	size_t size;
@@ -28,17 +30,19 @@ private:
 	size_t CountLessThan(int left, int right, T value, int position, int tl, int tr);
 
 public:
-	explicit SegmentTreeWithValues<T>(std::vector<T> vect);
+	explicit SegmentTreeWithValues(std::vector<T> vect);
 
 	size_t CountLessThan(int left, int right, T value);
 
-	~SegmentTreeWithValues<T>();
+	using StatsPolicy::Stats;
+
+	~SegmentTreeWithValues();
 };
 
 
 
-template <class T>
-SegmentTreeWithValues<T>::SegmentTreeWithValues<T>(std::vector<T> vect) {
+template <class T, class StatsPolicy>
+SegmentTreeWithValues<T, StatsPolicy>::SegmentTreeWithValues(std::vector<T> vect) {
 	size_t size_ = vect.size();
 	size_ = std::pow(2, findk(size_));
 	vect.resize(size_);
@@ -50,6 +54,7 @@ SegmentTreeWithValues<T>::SegmentTreeWithValues<T>(std::vector<T> vect) {
 
 	for (int i = size_ - 1; i < this->size; ++i) {
 		current = new Node_<T>(vect[i - size_ + 1]);
+		this->Allocate();
 		this->nodes[i] = current;
 	}//the last row of a tree = vect
 
@@ -77,31 +82,36 @@ SegmentTreeWithValues<T>::SegmentTreeWithValues<T>(std::vector<T> vect) {
 		}
 		current = new Node_<T>(this->nodes[2 * i + 1]->value + this->nodes[2 * i + 2]->value,
 			tmp_vect);
+		this->Allocate();
 		this->nodes[i] = current;
 	}
 }
 
-template <class T>
-SegmentTreeWithValues<T>::~SegmentTreeWithValues() {
+template <class T, class StatsPolicy>
+SegmentTreeWithValues<T, StatsPolicy>::~SegmentTreeWithValues() {
 	size_t size_ = (size + 1) / 2;
 	for (int i = size_ - 2; i >= 0; --i) {
 		delete this->nodes[2 * i + 2];
 		delete this->nodes[2 * i + 1];
+		this->Release(2);
 	}
 	delete this->nodes[0];
+	this->Release();
 }
 
 /*
      [left, right] ,    value*/
-template <class T>
-size_t SegmentTreeWithValues<T>::CountLessThan(int left, int right, T value) {
+template <class T, class StatsPolicy>
+size_t SegmentTreeWithValues<T, StatsPolicy>::CountLessThan(int left, int right, T value) {
+	typename StatsPolicy::Scope scope(*this, false);
 	return CountLessThan(left, right, value, 0, 0, (size + 1) / 2 - 1);
 }
 
 
 
-template <class T>
-size_t SegmentTreeWithValues<T>::CountLessThan(int left, int right, T value, int position, int tl, int tr) {
+template <class T, class StatsPolicy>
+size_t SegmentTreeWithValues<T, StatsPolicy>::CountLessThan(int left, int right, T value, int position, int tl, int tr) {
+	this->Visit();
 	if (tl >= left && tr <= right) {
 		//size_t count = 0;
 		int start = 0;
@@ -109,6 +119,7 @@ size_t SegmentTreeWithValues<T>::CountLessThan(int left, int right, T value, int
 		int mid = 0;// = (start + finish) / 2;
 		while (start <= finish) {
 			mid = (start + finish) / 2;
+			this->SearchStep();
 			if (this->nodes[position]->vect[mid] < value) {
 				start = mid + 1;
 				//count += mid;
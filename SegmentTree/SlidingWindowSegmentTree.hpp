@@ -0,0 +1,108 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+#include "SegmentTree.hpp"
+
+/*
+Sliding window segment tree keeps the last `window` pushed values. Leaves are used as a ring buffer:
+Push overwrites the oldest leaf and fixes up only its ancestors, so every push is O(log window) and
+the array is allocated once in the constructor.
+
+Indices in GetSum are window-relative: 0 is the oldest value still in the window, Count() - 1 is the newest.
+*/
+template <class T>
+class SlidingWindowSegmentTree {
+private:
+	size_t size;
+	size_t window;
+	size_t head;
+	size_t count;
+	std::vector<T> array;
+
+	T GetSum(size_t position, size_t tl, size_t tr, size_t l, size_t r);
+	T GetSumPhysical(size_t left, size_t right);
+public:
+	explicit SlidingWindowSegmentTree<T>(size_t window);
+
+	void Push(T value);
+
+	T GetSum(size_t left, size_t right);
+	T GetWindowSum();
+
+	size_t Count() { return count; }
+	size_t Window() { return window; }
+
+	~SlidingWindowSegmentTree() {}
+};
+
+template <class T>
+SlidingWindowSegmentTree<T>::SlidingWindowSegmentTree(size_t window) : window(window), head(0), count(0) {
+	if (!window)
+		throw 'e';
+	size_t size_ = std::pow(2, findk(window));
+	this->size = 2 * size_ - 1;
+	this->array.resize(this->size, T(0));
+}
+
+/*
+appends value to the window; once the window is full the oldest value is dropped
+*/
+template <class T>
+void SlidingWindowSegmentTree<T>::Push(T value) {
+	size_t slot;
+	if (count < window) {
+		slot = (head + count) % window;
+		++count;
+	}
+	else {
+		slot = head;
+		head = (head + 1) % window;
+	}
+
+	size_t i = (size + 1) / 2 - 1 + slot;
+	array[i] = value;
+	while (i) {
+		i = (i - 1) / 2;
+		array[i] = array[2 * i + 1] + array[2 * i + 2];
+	}
+}
+
+template <class T>
+T SlidingWindowSegmentTree<T>::GetWindowSum() {
+	return array[0];
+}
+
+/*
+sum of window-relative [left, right]; the range is mapped onto the ring and split in two if it wraps
+*/
+template <class T>
+T SlidingWindowSegmentTree<T>::GetSum(size_t left, size_t right) {
+	if (right >= count || right < left)
+		throw 'e';
+	size_t l = (head + left) % window;
+	size_t r = (head + right) % window;
+	if (l <= r)
+		return GetSumPhysical(l, r);
+	return GetSumPhysical(l, window - 1) + GetSumPhysical(0, r);
+}
+
+template <class T>
+T SlidingWindowSegmentTree<T>::GetSumPhysical(size_t left, size_t right) {
+	return GetSum(0, 0, (size + 1) / 2 - 1, left, right);
+}
+
+template <class T>
+T SlidingWindowSegmentTree<T>::GetSum(size_t position, size_t tl, size_t tr, size_t l, size_t r) {
+	if (tl >= l && tr <= r)
+		return array[position];
+	size_t mid = (tl + tr) / 2 + 1;
+	T ans = T(0);
+	if (l < mid) {
+		ans += GetSum(position * 2 + 1, tl, mid - 1, l, std::min(r, mid - 1));
+	}
+	if (r >= mid) {
+		ans += GetSum(position * 2 + 2, mid, tr, std::max(l, mid), r);
+	}
+	return ans;
+}
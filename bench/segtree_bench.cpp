@@ -0,0 +1,541 @@
+/*
+segtree_bench: reproducible workloads over every tree of the repository, results as JSON on stdout.
+
+	segtree_bench [--structures=a,b,...] [--distributions=uniform,zipf,sparse] [--reads=100,90,50]
+	              [--min-log=10] [--max-log=20] [--step-log=5] [--ops=1000000] [--max-seconds=10]
+	              [--zipf=0.99] [--sparse-shift=6] [--range=0] [--seed=1] [--output=file]
+
+Universe size is 2^log. uniform and zipf keep every position of the universe, sparse keeps
+2^(log - sparse-shift) positions spread over it. Keys of operations are drawn from the kept positions,
+uniformly or by an approximate Zipf law with hot keys scattered over the universe. --reads is the
+percentage of read operations. --range > 0 limits the length of queried ranges.
+
+Every (structure, distribution, reads, log) run reports build time, ops/sec, latency percentiles,
+peak RSS of the run and RSS growth per kept element. Built with SEGMENT_TREE_STATS or
+SEGMENT_TREE_STATS_PERF, the pointer trees also report their Stats() counters for the measured operations
+only (the build is not counted), live_nodes is the number of nodes at the end of the run. A run stops
+early after --max-seconds, then "truncated" is true and "ops" holds the number of operations done.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <malloc.h>
+
+#include "PersistentSegmentTree.hpp"
+#include "SlidingWindowSegmentTree.hpp"
+#include "SegmentTree2D.hpp"
+#include "FenwickTree.hpp"
+#include "SegmentTreeBeats.hpp"
+
+typedef long long value_t;
+
+struct Options {
+	std::vector<std::string> structures;
+	std::vector<std::string> distributions;
+	std::vector<int> reads;
+	int min_log;
+	int max_log;
+	int step_log;
+	size_t ops;
+	double max_seconds;
+	double zipf;
+	int sparse_shift;
+	size_t range;
+	uint64_t seed;
+	std::string output;
+};
+
+struct Op {
+	bool write;
+	size_t left;
+	size_t right;
+	value_t value;
+};
+
+struct Workload {
+	size_t universe;
+	std::vector<size_t> keys;
+	std::vector<value_t> values;
+	std::vector<Op> ops;
+};
+
+/*
+One structure under test: build it from the workload, then run single operations on it.
+Structures without a write operation set writes to false and get a read-only mix.
+*/
+struct Runner {
+	bool writes;
+	std::function<void()> build;
+	std::function<value_t(const Op&)> run;
+	std::function<void()> destroy;
+	std::function<TreeStats()> stats;
+};
+
+static const char* all_structures[] = {
+	"segment_tree", "segment_tree_with_values", "dynamic_segment_tree", "dynamic_segment_tree_sorted",
+	"compressed_tree", "compressed_tree_sorted",
+	"persistent_segment_tree", "fenwick_tree", "range_fenwick_tree", "segment_tree_beats",
+	"sliding_window_segment_tree", "segment_tree_2d"
+};
+
+static std::vector<std::string> Split(const std::string& line) {
+	std::vector<std::string> parts;
+	std::stringstream stream(line);
+	std::string part;
+	while (std::getline(stream, part, ','))
+		if (!part.empty())
+			parts.push_back(part);
+	return parts;
+}
+
+static Options Parse(int argc, char** argv) {
+	Options options;
+	options.structures.assign(std::begin(all_structures), std::end(all_structures));
+	options.distributions = { "uniform", "zipf", "sparse" };
+	options.reads = { 100, 90, 50 };
+	options.min_log = 10;
+	options.max_log = 20;
+	options.step_log = 5;
+	options.ops = 1000000;
+	options.max_seconds = 10;
+	options.zipf = 0.99;
+	options.sparse_shift = 6;
+	options.range = 0;
+	options.seed = 1;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		size_t eq = arg.find('=');
+		if (arg.compare(0, 2, "--") || eq == std::string::npos) {
+			std::cerr << "unknown argument " << arg << "\n";
+			std::exit(2);
+		}
+		std::string key = arg.substr(2, eq - 2);
+		std::string value = arg.substr(eq + 1);
+		if (key == "structures") {
+			options.structures = Split(value);
+			if (value == "all")
+				options.structures.assign(std::begin(all_structures), std::end(all_structures));
+		}
+		else if (key == "distributions") options.distributions = Split(value);
+		else if (key == "reads") {
+			options.reads.clear();
+			for (const std::string& part : Split(value))
+				options.reads.push_back(std::stoi(part));
+		}
+		else if (key == "min-log") options.min_log = std::stoi(value);
+		else if (key == "max-log") options.max_log = std::stoi(value);
+		else if (key == "step-log") options.step_log = std::max(1, std::stoi(value));
+		else if (key == "ops") options.ops = std::stoull(value);
+		else if (key == "max-seconds") options.max_seconds = std::stod(value);
+		else if (key == "zipf") options.zipf = std::stod(value);
+		else if (key == "sparse-shift") options.sparse_shift = std::stoi(value);
+		else if (key == "range") options.range = std::stoull(value);
+		else if (key == "seed") options.seed = std::stoull(value);
+		else if (key == "output") options.output = value;
+		else {
+			std::cerr << "unknown option --" << key << "\n";
+			std::exit(2);
+		}
+	}
+	return options;
+}
+
+/*
+rank in [0, count) by inverting the continuous power law x^-s, which approximates Zipf without a table
+*/
+static size_t ZipfRank(double u, size_t count, double s) {
+	double n = double(count) + 1;
+	double x;
+	if (std::fabs(s - 1) < 1e-9)
+		x = std::pow(n, u);
+	else
+		x = std::pow(u * (std::pow(n, 1 - s) - 1) + 1, 1 / (1 - s));
+	size_t rank = size_t(x) - 1;
+	return std::min(rank, count - 1);
+}
+
+static Workload MakeWorkload(const Options& options, const std::string& distribution, int log, int reads) {
+	Workload workload;
+	workload.universe = size_t(1) << log;
+	std::mt19937_64 rng(options.seed * 1000003 + log * 101 + reads);
+
+	size_t count = workload.universe;
+	if (distribution == "sparse")
+		count = size_t(1) << std::max(0, log - options.sparse_shift);
+	const uint64_t scatter = 0x9E3779B97F4A7C15ull;//odd, so i -> i * scatter mod 2^log is a bijection
+
+	workload.keys.resize(count);
+	workload.values.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		workload.keys[i] = count == workload.universe ? i : size_t(i * scatter) & (workload.universe - 1);
+		workload.values[i] = value_t(rng() % 10);
+	}
+	std::sort(workload.keys.begin(), workload.keys.end());
+
+	std::uniform_real_distribution<double> unit(0, 1);
+	auto next_key = [&]() {
+		size_t index;
+		if (distribution == "zipf")
+			index = size_t(ZipfRank(unit(rng), count, options.zipf) * scatter) & (count - 1);
+		else
+			index = rng() & (count - 1);
+		return index;
+	};
+
+	workload.ops.resize(options.ops);
+	for (Op& op : workload.ops) {
+		op.write = int(rng() % 100) >= reads;
+		size_t a = next_key();
+		size_t b = next_key();
+		if (options.range)
+			b = std::upper_bound(workload.keys.begin(), workload.keys.end(),
+				std::min(workload.keys[a] + rng() % options.range, workload.universe - 1)) - workload.keys.begin() - 1;
+		op.left = std::min(a, b);
+		op.right = std::max(a, b);
+		op.value = value_t(rng() % 10);
+	}
+	return workload;
+}
+
+/*
+counters of after minus counters of before, live_nodes is a current value and is kept as is
+*/
+static TreeStats Difference(const TreeStats& after, const TreeStats& before) {
+	TreeStats stats = after;
+	stats.queries -= before.queries;
+	stats.updates -= before.updates;
+	stats.nodes_visited -= before.nodes_visited;
+	stats.search_steps -= before.search_steps;
+	stats.allocations -= before.allocations;
+	stats.versions -= before.versions;
+	stats.cycles -= before.cycles;
+	stats.llc_misses -= before.llc_misses;
+	stats.perf_samples -= before.perf_samples;
+	return stats;
+}
+
+static std::vector<value_t> Dense(const Workload& workload) {
+	std::vector<value_t> vect(workload.universe, 0);
+	for (size_t i = 0; i < workload.keys.size(); ++i)
+		vect[workload.keys[i]] = workload.values[i];
+	return vect;
+}
+
+/*
+Operations address kept keys by index (op.left, op.right), array based trees translate them to
+positions of the universe, so every structure answers the same logical queries.
+*/
+static Runner MakeRunner(const std::string& name, const Workload& w) {
+	Runner runner;
+	runner.writes = true;
+	const std::vector<size_t>& keys = w.keys;
+
+	if (name == "segment_tree") {
+		auto tree = std::make_shared<SegmentTree<value_t>*>(nullptr);
+		runner.build = [tree, &w]() { *tree = new SegmentTree<value_t>(Dense(w)); };
+		runner.run = [tree, &keys](const Op& op) -> value_t {
+			if (op.write) {
+				(*tree)->SetElement(keys[op.left], op.value);
+				return 0;
+			}
+			return (*tree)->GetSum(int(keys[op.left]), int(keys[op.right]));
+		};
+		runner.destroy = [tree]() { delete *tree; };
+	}
+	else if (name == "segment_tree_with_values") {
+		auto tree = std::make_shared<SegmentTreeWithValues<value_t>*>(nullptr);
+		runner.writes = false;
+		runner.build = [tree, &w]() { *tree = new SegmentTreeWithValues<value_t>(Dense(w)); };
+		runner.run = [tree, &keys](const Op& op) -> value_t {
+			return value_t((*tree)->CountLessThan(int(keys[op.left]), int(keys[op.right]), op.value));
+		};
+		runner.destroy = [tree]() { delete *tree; };
+		runner.stats = [tree]() { return (*tree)->Stats(); };
+	}
+	else if (name == "dynamic_segment_tree" || name == "compressed_tree" ||
+		name == "dynamic_segment_tree_sorted" || name == "compressed_tree_sorted") {
+		//*_sorted are built by the bulk loaders from the sorted keys instead of one update per key
+		auto tree = std::make_shared<DynamicSegmentTree<value_t>*>(nullptr);
+		auto compressed = std::make_shared<CompressedTree<value_t>*>(nullptr);
+		bool compress = name.compare(0, 15, "compressed_tree") == 0;
+		bool sorted = name.size() > 7 && name.compare(name.size() - 7, 7, "_sorted") == 0;
+		runner.build = [tree, compressed, compress, sorted, &w]() {
+			if (sorted) {
+				std::vector<std::pair<size_t, value_t>> pairs(w.keys.size());
+				for (size_t i = 0; i < w.keys.size(); ++i)
+					pairs[i] = std::make_pair(w.keys[i], w.values[i]);
+				if (compress)
+					*compressed = new CompressedTree<value_t>(pairs.begin(), pairs.end());
+				else
+					*tree = DynamicSegmentTree<value_t>::FromSorted(pairs.begin(), pairs.end(), w.universe);
+				return;
+			}
+			*tree = new DynamicSegmentTree<value_t>(w.universe);
+			for (size_t i = 0; i < w.keys.size(); ++i)
+				(*tree)->UpdateElement(w.keys[i], w.values[i]);
+			if (compress) {
+				*compressed = new CompressedTree<value_t>((*tree)->Compress());
+				delete *tree;
+				*tree = nullptr;
+			}
+		};
+		if (compress) {
+			runner.run = [compressed, &keys](const Op& op) -> value_t {
+				if (op.write) {
+					(*compressed)->UpdateElement(keys[op.left], op.value);
+					return 0;
+				}
+				return (*compressed)->GetSum(keys[op.left], keys[op.right]);
+			};
+		}
+		else {
+			runner.run = [tree, &keys](const Op& op) -> value_t {
+				if (op.write) {
+					(*tree)->SetElement(keys[op.left], op.value);
+					return 0;
+				}
+				return (*tree)->GetSum(keys[op.left], keys[op.right]);
+			};
+		}
+		runner.destroy = [tree, compressed]() { delete *tree; delete *compressed; };
+		if (!compress)
+			runner.stats = [tree]() { return (*tree)->Stats(); };
+	}
+	else if (name == "persistent_segment_tree") {
+		auto tree = std::make_shared<PersistentSegmentTree<value_t>*>(nullptr);
+		auto version = std::make_shared<size_t>(0);
+		runner.build = [tree, version, &w]() { *tree = new PersistentSegmentTree<value_t>(Dense(w)); *version = 0; };
+		runner.run = [tree, version, &keys](const Op& op) -> value_t {
+			if (op.write) {
+				(*tree)->UpdateElement(keys[op.left], op.value);
+				++*version;
+				return 0;
+			}
+			return (*tree)->GetSum(keys[op.left], keys[op.right], *version);
+		};
+		runner.destroy = [tree]() { delete *tree; };
+		runner.stats = [tree]() { return (*tree)->Stats(); };
+	}
+	else if (name == "fenwick_tree") {
+		auto tree = std::make_shared<FenwickTree<value_t>*>(nullptr);
+		runner.build = [tree, &w]() { *tree = new FenwickTree<value_t>(Dense(w)); };
+		runner.run = [tree, &keys](const Op& op) -> value_t {
+			if (op.write) {
+				(*tree)->SetElement(keys[op.left], op.value);
+				return 0;
+			}
+			return (*tree)->GetSum(keys[op.left], keys[op.right]);
+		};
+		runner.destroy = [tree]() { delete *tree; };
+	}
+	else if (name == "range_fenwick_tree") {
+		auto tree = std::make_shared<RangeFenwickTree<value_t>*>(nullptr);
+		runner.build = [tree, &w]() { *tree = new RangeFenwickTree<value_t>(Dense(w)); };
+		runner.run = [tree, &keys](const Op& op) -> value_t {
+			if (op.write) {
+				(*tree)->UpdateRange(keys[op.left], keys[op.right], op.value);
+				return 0;
+			}
+			return (*tree)->GetSum(keys[op.left], keys[op.right]);
+		};
+		runner.destroy = [tree]() { delete *tree; };
+	}
+	else if (name == "segment_tree_beats") {
+		auto tree = std::make_shared<SegmentTreeBeats<value_t>*>(nullptr);
+		runner.build = [tree, &w]() { *tree = new SegmentTreeBeats<value_t>(Dense(w)); };
+		runner.run = [tree, &keys](const Op& op) -> value_t {
+			if (op.write) {
+				(*tree)->RangeChmin(keys[op.left], keys[op.right], op.value);
+				return 0;
+			}
+			return (*tree)->GetSum(keys[op.left], keys[op.right]);
+		};
+		runner.destroy = [tree]() { delete *tree; };
+	}
+	else if (name == "sliding_window_segment_tree") {
+		auto tree = std::make_shared<SlidingWindowSegmentTree<value_t>*>(nullptr);
+		runner.build = [tree, &w]() {
+			*tree = new SlidingWindowSegmentTree<value_t>(w.keys.size());
+			for (size_t i = 0; i < w.values.size(); ++i)
+				(*tree)->Push(w.values[i]);
+		};
+		runner.run = [tree](const Op& op) -> value_t {
+			if (op.write) {
+				(*tree)->Push(op.value);
+				return 0;
+			}
+			return (*tree)->GetSum(op.left, op.right);
+		};
+		runner.destroy = [tree]() { delete *tree; };
+	}
+	else if (name == "segment_tree_2d") {
+		//every kept key x gets one point (x, y(x)), rectangles are [x_left, x_right] x [0, universe / 2]
+		auto tree = std::make_shared<SegmentTree2D<value_t>*>(nullptr);
+		size_t mask = w.universe - 1;
+		runner.build = [tree, mask, &w]() {
+			std::vector<std::pair<size_t, size_t>> points(w.keys.size());
+			for (size_t i = 0; i < w.keys.size(); ++i)
+				points[i] = std::make_pair(w.keys[i], size_t(w.keys[i] * 0x9E3779B97F4A7C15ull) & mask);
+			*tree = new SegmentTree2D<value_t>(points);
+			for (size_t i = 0; i < w.keys.size(); ++i)
+				(*tree)->UpdateElement(points[i].first, points[i].second, w.values[i]);
+		};
+		runner.run = [tree, mask, &keys](const Op& op) -> value_t {
+			if (op.write) {
+				size_t x = keys[op.left];
+				(*tree)->UpdateElement(x, size_t(x * 0x9E3779B97F4A7C15ull) & mask, op.value);
+				return 0;
+			}
+			return (*tree)->GetSum(keys[op.left], keys[op.right], 0, mask / 2);
+		};
+		runner.destroy = [tree]() { delete *tree; };
+	}
+	else {
+		std::cerr << "unknown structure " << name << "\n";
+		std::exit(2);
+	}
+	return runner;
+}
+
+/*
+VmRSS / VmHWM from /proc/self/status in bytes, 0 where it is not available
+*/
+static size_t ReadStatus(const char* field) {
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	size_t length = std::char_traits<char>::length(field);
+	while (std::getline(status, line)) {
+		if (!line.compare(0, length, field))
+			return size_t(std::strtoull(line.c_str() + length + 1, nullptr, 10)) * 1024;
+	}
+	return 0;
+}
+
+static void ResetPeak() {
+	std::ofstream clear_refs("/proc/self/clear_refs");
+	clear_refs << "5";
+}
+
+static uint64_t Percentile(const std::vector<uint64_t>& sorted, double p) {
+	if (sorted.empty())
+		return 0;
+	size_t index = size_t(p * double(sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+int main(int argc, char** argv) {
+	Options options = Parse(argc, argv);
+	typedef std::chrono::steady_clock clock;
+
+	std::ostringstream json;
+	json << "{\n\t\"benchmark\": \"segtree_bench\",\n\t\"config\": {\"ops\": " << options.ops
+		<< ", \"max_seconds\": " << options.max_seconds << ", \"zipf\": " << options.zipf
+		<< ", \"sparse_shift\": " << options.sparse_shift << ", \"range\": " << options.range
+		<< ", \"seed\": " << options.seed << ", \"value_bytes\": " << sizeof(value_t) << "},\n\t\"results\": [";
+
+	volatile value_t sink = 0;
+	bool first = true;
+	for (const std::string& distribution : options.distributions) {
+		for (int reads : options.reads) {
+			for (int log = options.min_log; log <= options.max_log; log += options.step_log) {
+				Workload workload = MakeWorkload(options, distribution, log, reads);
+				for (const std::string& name : options.structures) {
+					Runner runner = MakeRunner(name, workload);
+					int actual_reads = runner.writes ? reads : 100;
+					std::cerr << name << " " << distribution << " reads=" << actual_reads << " log=" << log << "\n";
+
+					malloc_trim(0);
+					ResetPeak();
+					size_t rss_before = ReadStatus("VmRSS:");
+
+					auto build_start = clock::now();
+					runner.build();
+					double build_seconds = std::chrono::duration<double>(clock::now() - build_start).count();
+					size_t rss_built = ReadStatus("VmRSS:");
+					TreeStats built = runner.stats ? runner.stats() : TreeStats();
+
+					std::vector<uint64_t> latencies;
+					latencies.reserve(workload.ops.size());
+					bool truncated = false;
+					auto run_start = clock::now();
+					auto deadline = run_start + std::chrono::duration_cast<clock::duration>(
+						std::chrono::duration<double>(options.max_seconds));
+					for (Op op : workload.ops) {
+						op.write = op.write && runner.writes;
+						auto start = clock::now();
+						sink = sink + runner.run(op);
+						auto finish = clock::now();
+						latencies.push_back(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count()));
+						if (finish > deadline) {
+							truncated = latencies.size() < workload.ops.size();
+							break;
+						}
+					}
+					double run_seconds = std::chrono::duration<double>(clock::now() - run_start).count();
+					size_t peak = ReadStatus("VmHWM:");
+					TreeStats stats = Difference(runner.stats ? runner.stats() : TreeStats(), built);
+					runner.destroy();
+
+					std::sort(latencies.begin(), latencies.end());
+					double bytes_per_element = rss_built > rss_before
+						? double(rss_built - rss_before) / double(workload.keys.size()) : 0;
+
+					json << (first ? "\n" : ",\n") << "\t\t{\"structure\": \"" << name
+						<< "\", \"distribution\": \"" << distribution
+						<< "\", \"read_percent\": " << actual_reads
+						<< ", \"log_size\": " << log
+						<< ", \"universe\": " << workload.universe
+						<< ", \"elements\": " << workload.keys.size()
+						<< ", \"build_seconds\": " << build_seconds
+						<< ", \"ops\": " << latencies.size()
+						<< ", \"truncated\": " << (truncated ? "true" : "false")
+						<< ", \"ops_per_second\": " << (run_seconds > 0 ? double(latencies.size()) / run_seconds : 0)
+						<< ", \"latency_ns\": {\"p50\": " << Percentile(latencies, 0.5)
+						<< ", \"p90\": " << Percentile(latencies, 0.9)
+						<< ", \"p99\": " << Percentile(latencies, 0.99)
+						<< ", \"p999\": " << Percentile(latencies, 0.999)
+						<< ", \"max\": " << (latencies.empty() ? 0 : latencies.back()) << "}"
+						<< ", \"peak_rss_bytes\": " << peak
+						<< ", \"bytes_per_element\": " << bytes_per_element;
+					if (runner.stats && !std::is_same<DefaultStats, NoStats>::value) {
+						json << ", \"stats\": {\"queries\": " << stats.queries
+							<< ", \"updates\": " << stats.updates
+							<< ", \"nodes_visited\": " << stats.nodes_visited
+							<< ", \"search_steps\": " << stats.search_steps
+							<< ", \"allocations\": " << stats.allocations
+							<< ", \"live_nodes\": " << stats.live_nodes
+							<< ", \"versions\": " << stats.versions
+							<< ", \"cycles\": " << stats.cycles
+							<< ", \"llc_misses\": " << stats.llc_misses
+							<< ", \"perf_samples\": " << stats.perf_samples << "}";
+					}
+					json << "}";
+					first = false;
+				}
+			}
+		}
+	}
+	json << "\n\t]\n}\n";
+
+	if (options.output.empty()) {
+		std::cout << json.str();
+	}
+	else {
+		std::ofstream output(options.output);
+		output << json.str();
+	}
+	return 0;
+}